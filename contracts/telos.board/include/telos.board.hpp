@@ -12,6 +12,7 @@
 #include <eosio/asset.hpp>
 #include <eosio/action.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eosio/transaction.hpp>
 
 using namespace std;
@@ -71,12 +72,31 @@ public:
 		PASS = 1
 	};
 
+	// Per-row RAM overhead billed by the chain for a multi_index / singleton row
+	static constexpr uint64_t ROW_RAM_OVERHEAD = 112;
+
+	// Current row layout of each versioned table. Rows written with an older
+	// version are upgraded when touched or through migrate(), version 0 is the
+	// original layout without schema_version.
+
+	// 1: schema_version added
+	static constexpr uint8_t NOMINEE_SCHEMA_VERSION = 1;
+
+	// 1: schema_version added
+	static constexpr uint8_t SEAT_SCHEMA_VERSION = 1;
+
+	// 1: nominator_pays_ram and schema_version added
+	static constexpr uint8_t CONFIG_SCHEMA_VERSION = 1;
+
     #pragma endregion Constants
 
     struct [[eosio::table]] board_nominee {
         name nominee;
+        binary_extension<name> ram_payer; // Account paying the RAM for this row, the contract if not set
+        binary_extension<uint8_t> schema_version;
+
         uint64_t primary_key() const { return nominee.value; }
-        EOSLIB_SERIALIZE(board_nominee, (nominee))
+        EOSLIB_SERIALIZE(board_nominee, (nominee)(ram_payer)(schema_version))
     };
 
     struct [[eosio::table]] board_seat {
@@ -84,10 +104,11 @@ public:
 
         name member; // Current member in the board - if it's empty means that no one is holding this seat
         uint32_t next_election_time; // Next election time
+        binary_extension<uint8_t> schema_version;
 
         uint64_t primary_key() const { return id; }
 
-        EOSLIB_SERIALIZE(board_seat, (id)(member)(next_election_time))
+        EOSLIB_SERIALIZE(board_seat, (id)(member)(next_election_time)(schema_version))
     };
 
     struct [[eosio::table]] configv2 {
@@ -101,10 +122,37 @@ public:
         uint32_t election_frequency = 14515200;
         uint32_t active_election_min_start_time = 0;
         bool is_active_election = false;
+        binary_extension<bool> nominator_pays_ram; // If true, nominators pay the RAM for their nominations
+        binary_extension<uint8_t> schema_version;
 
         uint64_t primary_key() const { return publisher.value; }
         EOSLIB_SERIALIZE(configv2, (publisher)(open_election_id)(holder_quorum_divisor)
-            (board_quorum_divisor)(issue_duration)(start_delay)(leaderboard_duration)(election_frequency)(active_election_min_start_time)(is_active_election))
+            (board_quorum_divisor)(issue_duration)(start_delay)(leaderboard_duration)(election_frequency)(active_election_min_start_time)(is_active_election)
+            (nominator_pays_ram)(schema_version))
+    };
+
+    struct [[eosio::table]] table_stats {
+        name table_name;
+        uint64_t rows = 0;
+        uint64_t bytes = 0; // Estimated RAM paid by the contract, including the per-row overhead
+        uint64_t user_bytes = 0; // Estimated RAM paid by other accounts, including the per-row overhead
+        uint64_t max_rows = 0; // 0 means no cap
+        bool synced = false; // False until every row in the table has been counted by syncstats
+        uint64_t sync_key = 0; // While not synced, only rows with a primary key below this are counted
+
+        uint64_t primary_key() const { return table_name.value; }
+        bool counts_key(uint64_t key) const { return synced || key < sync_key; }
+        EOSLIB_SERIALIZE(table_stats, (table_name)(rows)(bytes)(user_bytes)(max_rows)(synced)(sync_key))
+    };
+
+    struct [[eosio::table]] migration_cursor {
+        name table_name;
+        uint8_t schema_version = 0; // Version this table is being migrated to
+        uint64_t next_key = 0;
+        bool done = false;
+
+        uint64_t primary_key() const { return table_name.value; }
+        EOSLIB_SERIALIZE(migration_cursor, (table_name)(schema_version)(next_key)(done))
     };
 
 	//TODO: create multisig compatible packed_trx table for proposals.
@@ -118,6 +166,11 @@ public:
     config_table configs;
     configv2 _config;
 
+    typedef multi_index<name("tablestats"), table_stats> stats_table;
+    stats_table stats;
+
+    typedef multi_index<name("migration"), migration_cursor> migration_table;
+
     [[eosio::action]]
     void setconfig(name publisher, configv2 new_config);
 
@@ -133,6 +186,9 @@ public:
 	[[eosio::action]]
 	void removecand(name candidate);
 
+	[[eosio::action]]
+	void removenom(name nominee);
+
     [[eosio::action]]
     void startelect(name holder);
 
@@ -157,6 +213,18 @@ public:
     [[eosio::action]]
     void updseatterms(std::map<uint32_t, uint32_t> seat_terms);
 
+    [[eosio::action]]
+    void setrowcap(name table_name, uint64_t max_rows);
+
+    [[eosio::action]]
+    void syncstats(uint32_t max_rows);
+
+    [[eosio::action]]
+    void ramusage();
+
+    [[eosio::action]]
+    void migrate(uint32_t max_rows);
+
 	//TODO: board member multisig kick action
 			//Starts run off leaderboard at start/end
 
@@ -188,6 +256,23 @@ public:
     seats_table::const_iterator get_next_empty_seat();
     bool is_empty_seat(seats_table::const_iterator& seat);
 
+    bool is_cappable_table(name table_name);
+    stats_table::const_iterator get_table_stats(name table_name, bool synced);
+    uint64_t get_stored_size(name table_name, uint64_t key);
+    void add_row_stats(name table_name, uint64_t key, uint64_t row_size, name payer);
+    void remove_row_stats(name table_name, uint64_t key, uint64_t row_size, name payer);
+    void resize_row_stats(name table_name, uint64_t key, uint64_t old_size, uint64_t new_size, name payer);
+
+    bool upgrade_nominee(board_nominee& nominee);
+    bool upgrade_nominee_row(nominees_table& noms, nominees_table::const_iterator nominee);
+    bool upgrade_seat(board_seat& seat);
+    bool upgrade_config(configv2& config);
+
+    template<typename Lambda>
+    void modify_seat(seats_table::const_iterator seat, Lambda&& updater);
+
+    migration_table::const_iterator get_migration_cursor(migration_table& migration, name table_name, uint8_t schema_version);
+
     #pragma endregion Helper_Functions
 
 };
@@ -4,9 +4,16 @@
 tfvt::tfvt(name self, name code, datastream<const char*> ds)
 : contract(self, code, ds),
   configs(get_self(), get_self().value),
-  seats(get_self(), get_self().value) {
+  seats(get_self(), get_self().value),
+  stats(get_self(), get_self().value) {
 	print("\n exists?: ", configs.exists());
 	_config = configs.exists() ? configs.get() : get_default_config();
+	upgrade_config(_config);
+
+	// The destructor rewrites the config with every extension, so a row stored
+	// with an older layout grows on the first action
+	resize_row_stats(name("configv2"), 0, get_stored_size(name("configv2"), name("configv2").value),
+		pack_size(_config), get_self());
 }
 
 tfvt::~tfvt() {
@@ -24,9 +31,17 @@ tfvt::configv2 tfvt::get_default_config() {
 		uint32_t(2000000),  //leaderboard_duration
 		uint32_t(14515200),	//election_frequency
 		uint32_t(0),		//active election min time to start
-		false				//is_active_election
+		false,				//is_active_election
+		binary_extension<bool>(false), //nominator_pays_ram
+		binary_extension<uint8_t>(CONFIG_SCHEMA_VERSION) //schema_version
 	};
 	configs.set(c, get_self());
+
+	// Every table is empty on a fresh contract, so there is nothing to sync
+	get_table_stats(name("boardseat"), true);
+	get_table_stats(name("nominees"), true);
+	get_table_stats(name("configv2"), true);
+	add_row_stats(name("configv2"), 0, pack_size(c), get_self());
 	return c;
 }
 
@@ -34,6 +49,7 @@ tfvt::configv2 tfvt::get_default_config() {
 
 void tfvt::setconfig(name member, configv2 new_config) {
     require_auth(get_self());
+	remove_row_stats(name("configv2"), 0, pack_size(_config), get_self());
 	configs.remove();
 	check(new_config.holder_quorum_divisor > 0, "holder_quorum_divisor must be a non-zero number");
 	check(new_config.board_quorum_divisor > 0, "board_quorum_divisor must be a non-zero number");
@@ -46,8 +62,12 @@ void tfvt::setconfig(name member, configv2 new_config) {
 	new_config.open_election_id = _config.open_election_id;
 	new_config.is_active_election = _config.is_active_election;
 
+	check(new_config.schema_version.value_or(0) <= CONFIG_SCHEMA_VERSION, "schema_version is newer than this contract");
+	upgrade_config(new_config);
+
 	_config = new_config;
 	configs.set(_config, get_self());
+	add_row_stats(name("configv2"), 0, pack_size(_config), get_self());
 }
 
 void tfvt::nominate(name nominee, name nominator) {
@@ -58,9 +78,13 @@ void tfvt::nominate(name nominee, name nominator) {
     auto n = noms.find(nominee.value);
     check(n == noms.end(), "nominee has already been nominated");
 
-    noms.emplace(get_self(), [&](auto& m) {
+    auto payer = _config.nominator_pays_ram.value_or(false) ? nominator : get_self();
+    auto nom = noms.emplace(payer, [&](auto& m) {
         m.nominee = nominee;
+        m.ram_payer.emplace(payer);
+        m.schema_version.emplace(NOMINEE_SCHEMA_VERSION);
     });
+    add_row_stats(name("nominees"), nom->nominee.value, pack_size(*nom), payer);
 }
 
 void tfvt::makeelection(name holder, std::string description, std::string content) {
@@ -99,7 +123,7 @@ void tfvt::makeelection(name holder, std::string description, std::string conten
     // Remove all the expired seats
     for (auto itr = seats.begin(); itr != seats.end(); itr++) {
         if (is_term_expired(itr->next_election_time))  {
-            seats.modify(itr, get_self(), [&](auto& s) {
+            modify_seat(itr, [&](auto& s) {
                 s.member = name();
             });
         }
@@ -112,9 +136,13 @@ void tfvt::makeelection(name holder, std::string description, std::string conten
 
 void tfvt::addcand(name candidate) {
 	require_auth(candidate);
-	check(is_nominee(candidate), "only nominees can be added to the election");
 	check(_config.is_active_election, "no active election for board members at this time");
 
+	nominees_table noms(get_self(), get_self().value);
+	auto nom = noms.find(candidate.value);
+	check(nom != noms.end(), "only nominees can be added to the election");
+	upgrade_nominee_row(noms, nom);
+
 	auto seat = get_board_seat_by_user(candidate);
 
 	check(seat == seats.end() || is_term_expired(seat->next_election_time), "nominee can't already be a board member, or their term must be expired.");
@@ -135,6 +163,25 @@ void tfvt::removecand(name candidate) {
 	)).send();
 }
 
+void tfvt::removenom(name nominee) {
+	check(has_auth(nominee) || has_auth(get_self()), "missing authority of nominee or contract");
+
+	nominees_table noms(get_self(), get_self().value);
+	auto n = noms.find(nominee.value);
+	check(n != noms.end(), "nominee doesn't exist in table");
+
+	// endelect needs the nominee row of everyone on the open ballot
+	if (_config.is_active_election) {
+		ballots_table ballots(TELOS_DECIDE_N, TELOS_DECIDE_N.value);
+		auto bal = ballots.find(_config.open_election_id.value);
+		check(bal == ballots.end() || bal->options.count(nominee) == 0, "nominee is a candidate in the open election");
+	}
+
+	remove_row_stats(name("nominees"), n->nominee.value, get_stored_size(name("nominees"), n->nominee.value),
+		n->ram_payer.value_or(get_self()));
+	noms.erase(n);
+}
+
 void tfvt::startelect(name holder) {
 	require_auth(holder);
 	check(_config.is_active_election, "there is no active election to start");
@@ -240,6 +287,7 @@ void tfvt::removeseat(uint32_t seat_id) {
     auto seat = seats.find(seat_id);
     check(seat != seats.end(), "Unknown seat");
     check(is_empty_seat(seat), "Seat is not empty");
+    remove_row_stats(name("boardseat"), seat->id, get_stored_size(name("boardseat"), seat->id), get_self());
     seats.erase(seat);
 }
 
@@ -249,12 +297,147 @@ void tfvt::updseatterms(std::map<uint32_t, uint32_t> seat_terms) {
     for (auto const& it : seat_terms) {
         auto seat = seats.find(it.first);
         check(seat != seats.end(), "Unknown seat");
-        seats.modify(seat, get_self(), [&](auto& s) {
+        modify_seat(seat, [&](auto& s) {
             s.next_election_time = it.second;
         });
     }
 }
 
+void tfvt::setrowcap(name table_name, uint64_t max_rows) {
+    require_auth(get_self());
+    check(is_cappable_table(table_name), "table can't be capped");
+
+    auto st = stats.find(table_name.value);
+    check(st != stats.end() && st->synced, "table stats must be synced with syncstats before setting a cap");
+    stats.modify(st, get_self(), [&](auto& s) {
+        s.max_rows = max_rows;
+    });
+}
+
+void tfvt::syncstats(uint32_t max_rows) {
+    require_auth(get_self());
+    check(max_rows > 0, "max_rows must be a non-zero number");
+
+    // Counts rows written before stats were kept, resuming from each table's sync_key
+    uint32_t scanned = 0;
+
+    auto st = get_table_stats(name("boardseat"), false);
+    if (!st->synced) {
+        table_stats counted = *st;
+        auto itr = seats.lower_bound(counted.sync_key);
+        for (; itr != seats.end() && scanned < max_rows; itr++, scanned++) {
+            counted.rows++;
+            counted.bytes += get_stored_size(name("boardseat"), itr->id) + ROW_RAM_OVERHEAD;
+            counted.sync_key = itr->id + 1;
+        }
+        counted.synced = itr == seats.end();
+
+        stats.modify(st, get_self(), [&](auto& s) {
+            s = counted;
+        });
+    }
+
+    st = get_table_stats(name("nominees"), false);
+    if (!st->synced) {
+        table_stats counted = *st;
+        nominees_table noms(get_self(), get_self().value);
+        auto itr = noms.lower_bound(counted.sync_key);
+        for (; itr != noms.end() && scanned < max_rows; itr++, scanned++) {
+            uint64_t row_bytes = get_stored_size(name("nominees"), itr->nominee.value) + ROW_RAM_OVERHEAD;
+            counted.rows++;
+            if (itr->ram_payer.value_or(get_self()) == get_self()) {
+                counted.bytes += row_bytes;
+            } else {
+                counted.user_bytes += row_bytes;
+            }
+            counted.sync_key = itr->nominee.value + 1;
+        }
+        counted.synced = itr == noms.end();
+
+        stats.modify(st, get_self(), [&](auto& s) {
+            s = counted;
+        });
+    }
+
+    st = get_table_stats(name("configv2"), false);
+    if (!st->synced) {
+        stats.modify(st, get_self(), [&](auto& s) {
+            s.rows = 1;
+            s.bytes = pack_size(_config) + ROW_RAM_OVERHEAD;
+            s.synced = true;
+        });
+    }
+
+    print("\n scanned rows: ", scanned);
+}
+
+void tfvt::ramusage() {
+    uint64_t contract_bytes = 0;
+    uint64_t user_bytes = 0;
+    for (auto itr = stats.begin(); itr != stats.end(); itr++) {
+        print("\n", itr->table_name, ": rows=", itr->rows, " contract_bytes=", itr->bytes,
+            " user_bytes=", itr->user_bytes, " max_rows=", itr->max_rows, " synced=", itr->synced);
+        contract_bytes += itr->bytes;
+        user_bytes += itr->user_bytes;
+    }
+    print("\n contract paid bytes: ", contract_bytes);
+    print("\n user paid bytes: ", user_bytes);
+}
+
+void tfvt::migrate(uint32_t max_rows) {
+    require_auth(get_self());
+    check(max_rows > 0, "max_rows must be a non-zero number");
+
+    migration_table migration(get_self(), get_self().value);
+    uint32_t scanned = 0;
+    uint32_t upgraded = 0;
+
+    auto cursor = get_migration_cursor(migration, name("boardseat"), SEAT_SCHEMA_VERSION);
+    if (!cursor->done) {
+        uint64_t next_key = cursor->next_key;
+        auto itr = seats.lower_bound(next_key);
+        for (; itr != seats.end() && scanned < max_rows; itr++, scanned++) {
+            next_key = itr->id + 1;
+            if (itr->schema_version.value_or(0) < SEAT_SCHEMA_VERSION) {
+                modify_seat(itr, [](auto& s) {});
+                upgraded++;
+            }
+        }
+
+        migration.modify(cursor, get_self(), [&](auto& c) {
+            c.next_key = next_key;
+            c.done = itr == seats.end();
+        });
+    }
+
+    cursor = get_migration_cursor(migration, name("nominees"), NOMINEE_SCHEMA_VERSION);
+    if (!cursor->done) {
+        nominees_table noms(get_self(), get_self().value);
+        uint64_t next_key = cursor->next_key;
+        auto itr = noms.lower_bound(next_key);
+        for (; itr != noms.end() && scanned < max_rows; itr++, scanned++) {
+            next_key = itr->nominee.value + 1;
+            if (upgrade_nominee_row(noms, itr)) {
+                upgraded++;
+            }
+        }
+
+        migration.modify(cursor, get_self(), [&](auto& c) {
+            c.next_key = next_key;
+            c.done = itr == noms.end();
+        });
+    }
+
+    bool complete = true;
+    for (auto itr = migration.begin(); itr != migration.end(); itr++) {
+        complete = complete && itr->done;
+    }
+
+    print("\n scanned rows: ", scanned);
+    print("\n upgraded rows: ", upgraded);
+    print("\n migration complete?: ", complete);
+}
+
 #pragma endregion Actions
 
 
@@ -265,13 +448,15 @@ void tfvt::add_to_tfboard(name nominee) {
     auto n = noms.find(nominee.value);
     check(n != noms.end(), "nominee doesn't exist in table");
     auto seat = get_next_empty_seat();
-    seats.modify(seat, get_self(), [&](auto& s) {
+    modify_seat(seat, [&](auto& s) {
         s.member = nominee;
         if (is_term_expired(s.next_election_time)) {
             s.next_election_time += _config.election_frequency;
         }
     });
 
+    remove_row_stats(name("nominees"), n->nominee.value, get_stored_size(name("nominees"), n->nominee.value),
+        n->ram_payer.value_or(get_self()));
     noms.erase(n);
 }
 
@@ -279,11 +464,13 @@ void tfvt::addseats(uint8_t num_seats) {
     require_auth(get_self());
 
     for (size_t i = 0; i < num_seats; ++i) {
-        seats.emplace(get_self(), [&](auto& s) {
+        auto seat = seats.emplace(get_self(), [&](auto& s) {
             s.id = seats.available_primary_key();
             s.member = name();
             s.next_election_time = current_time_point().sec_since_epoch();
+            s.schema_version.emplace(SEAT_SCHEMA_VERSION);
         });
+        add_row_stats(name("boardseat"), seat->id, pack_size(*seat), get_self());
     }
 }
 
@@ -319,7 +506,7 @@ void tfvt::remove_and_seize(name member) {
 	auto seat = get_board_seat_by_user(member);
 	check(seat != seats.end(), "board member not found");
 
-    seats.modify(seat, get_self(), [&](auto& s) {
+    modify_seat(seat, [&](auto& s) {
         s.member = name();
     });
 }
@@ -447,4 +634,163 @@ bool tfvt::is_empty_seat(seats_table::const_iterator& seat) {
     return seat->member == name() || is_term_expired(seat->next_election_time);
 }
 
+bool tfvt::is_cappable_table(name table_name) {
+    return table_name == name("nominees") || table_name == name("boardseat");
+}
+
+tfvt::stats_table::const_iterator tfvt::get_table_stats(name table_name, bool synced) {
+    auto st = stats.find(table_name.value);
+    if (st == stats.end()) {
+        st = stats.emplace(get_self(), [&](auto& s) {
+            s.table_name = table_name;
+            s.synced = synced;
+        });
+    }
+
+    return st;
+}
+
+uint64_t tfvt::get_stored_size(name table_name, uint64_t key) {
+    // Size of the row as stored, rows from older layouts lack their newer extensions
+    auto itr = internal_use_do_not_use::db_find_i64(get_self().value, get_self().value, table_name.value, key);
+    return itr >= 0 ? internal_use_do_not_use::db_get_i64(itr, nullptr, 0) : 0;
+}
+
+void tfvt::add_row_stats(name table_name, uint64_t key, uint64_t row_size, name payer) {
+    // Stats rows created here belong to tables that predate stats, they start unsynced
+    auto st = get_table_stats(table_name, false);
+
+    check(st->max_rows == 0 || st->rows < st->max_rows, "row cap reached for table");
+    if (!st->counts_key(key)) {
+        return;
+    }
+
+    stats.modify(st, get_self(), [&](auto& s) {
+        s.rows++;
+        if (payer == get_self()) {
+            s.bytes += row_size + ROW_RAM_OVERHEAD;
+        } else {
+            s.user_bytes += row_size + ROW_RAM_OVERHEAD;
+        }
+    });
+}
+
+void tfvt::resize_row_stats(name table_name, uint64_t key, uint64_t old_size, uint64_t new_size, name payer) {
+    auto st = stats.find(table_name.value);
+    if (st == stats.end() || !st->counts_key(key) || old_size == new_size) {
+        return;
+    }
+
+    stats.modify(st, get_self(), [&](auto& s) {
+        auto& bytes = payer == get_self() ? s.bytes : s.user_bytes;
+        bytes = bytes + new_size - old_size;
+    });
+}
+
+void tfvt::remove_row_stats(name table_name, uint64_t key, uint64_t row_size, name payer) {
+    auto st = stats.find(table_name.value);
+    if (st == stats.end() || !st->counts_key(key)) {
+        return;
+    }
+
+    stats.modify(st, get_self(), [&](auto& s) {
+        s.rows--;
+        if (payer == get_self()) {
+            s.bytes -= row_size + ROW_RAM_OVERHEAD;
+        } else {
+            s.user_bytes -= row_size + ROW_RAM_OVERHEAD;
+        }
+    });
+}
+
+template<typename Lambda>
+void tfvt::modify_seat(seats_table::const_iterator seat, Lambda&& updater) {
+    // Upgrades the seat to the current schema first, without changing its payer
+    uint64_t old_size = get_stored_size(name("boardseat"), seat->id);
+    seats.modify(seat, same_payer, [&](auto& s) {
+        upgrade_seat(s);
+        updater(s);
+    });
+    resize_row_stats(name("boardseat"), seat->id, old_size, pack_size(*seat), get_self());
+}
+
+bool tfvt::upgrade_nominee_row(nominees_table& noms, nominees_table::const_iterator nominee) {
+    // Growing a row bills its payer, so rows paid by an account that didn't sign keep their old layout
+    name payer = nominee->ram_payer.value_or(get_self());
+    if (payer != get_self() && !has_auth(payer)) {
+        return false;
+    }
+
+    auto upgraded = *nominee;
+    if (!upgrade_nominee(upgraded)) {
+        return false;
+    }
+
+    uint64_t old_size = get_stored_size(name("nominees"), nominee->nominee.value);
+    noms.modify(nominee, same_payer, [&](auto& n) {
+        n = upgraded;
+    });
+    resize_row_stats(name("nominees"), upgraded.nominee.value, old_size, pack_size(upgraded), payer);
+    return true;
+}
+
+tfvt::migration_table::const_iterator tfvt::get_migration_cursor(migration_table& migration, name table_name, uint8_t schema_version) {
+    auto cursor = migration.find(table_name.value);
+    if (cursor == migration.end()) {
+        return migration.emplace(get_self(), [&](auto& c) {
+            c.table_name = table_name;
+            c.schema_version = schema_version;
+        });
+    }
+
+    // Only a table whose version went up is walked again
+    if (cursor->schema_version < schema_version) {
+        migration.modify(cursor, get_self(), [&](auto& c) {
+            c.schema_version = schema_version;
+            c.next_key = 0;
+            c.done = false;
+        });
+    }
+
+    return cursor;
+}
+
+bool tfvt::upgrade_nominee(board_nominee& nominee) {
+    if (nominee.schema_version.value_or(0) >= NOMINEE_SCHEMA_VERSION) {
+        return false;
+    }
+
+    // An absent ram_payer means the contract paid. Written out as the default name()
+    // it would read back as a user payer, so it is filled in before the row is rewritten.
+    if (!nominee.ram_payer.has_value()) {
+        nominee.ram_payer.emplace(get_self());
+    }
+
+    nominee.schema_version.emplace(NOMINEE_SCHEMA_VERSION);
+    return true;
+}
+
+bool tfvt::upgrade_seat(board_seat& seat) {
+    if (seat.schema_version.value_or(0) >= SEAT_SCHEMA_VERSION) {
+        return false;
+    }
+
+    seat.schema_version.emplace(SEAT_SCHEMA_VERSION);
+    return true;
+}
+
+bool tfvt::upgrade_config(configv2& config) {
+    if (config.schema_version.value_or(0) >= CONFIG_SCHEMA_VERSION) {
+        return false;
+    }
+
+    // Configs from before nominator_pays_ram keep the contract paying for nominations
+    if (!config.nominator_pays_ram.has_value()) {
+        config.nominator_pays_ram.emplace(false);
+    }
+
+    config.schema_version.emplace(CONFIG_SCHEMA_VERSION);
+    return true;
+}
+
 #pragma endregion Helper_Functions